@@ -11,16 +11,20 @@
 #include <atta/componentSystem/components/component.h>
 #include <atta/componentSystem/componentRegistry.h>
 #include <atta/fileSystem/serializer/serializer.h>
+#include "coverageGrid.h"
 using namespace atta;
 
 struct GAComponent final : public Component
 {  
     std::vector<std::vector<float>> robotFitness;// For each generation, fitness of each robot
     std::vector<bnd2f> robotBounds;// For each robot, the area explored
+    std::vector<CoverageGrid> robotCoverage;// For each robot, the cells visited
+    uint32_t fitnessType;
     float mutationRate;
     uint32_t crossingType;
     uint32_t fitnessSmooth;
     uint32_t predationInterval;
+    uint32_t recordMode;// Trajectories saved at the end of each generation (every robot is buffered until then)
 
     uint32_t currGen;// Current generation
     uint32_t currEval;// Current evaluation
@@ -37,11 +41,15 @@ inline ComponentRegistry::Description TypedComponentRegistry<GAComponent>::descr
     {
         { ComponentRegistry::AttributeType::CUSTOM, offsetof(GAComponent, robotFitness), "robotFitness" },
         { ComponentRegistry::AttributeType::CUSTOM, offsetof(GAComponent, robotBounds), "robotBounds" },
+        { ComponentRegistry::AttributeType::UINT32, offsetof(GAComponent, fitnessType), "fitnessType", {}, {}, {}, 
+            {"Bounding box", "Coverage grid"} },
         { ComponentRegistry::AttributeType::FLOAT32, offsetof(GAComponent, mutationRate), "mutationRate", 0.0f, 1.0f, 0.05f },
         { ComponentRegistry::AttributeType::UINT32, offsetof(GAComponent, crossingType), "crossingType", {}, {}, {}, 
-            {"Best fitness", "Best smooth"} },
+            {"Best smooth", "Best fitness"} },// 0: mean over fitnessSmooth generations, 1: last generation
         { ComponentRegistry::AttributeType::UINT32, offsetof(GAComponent, fitnessSmooth), "fitnessSmooth", 1u, 10u },
         { ComponentRegistry::AttributeType::UINT32, offsetof(GAComponent, predationInterval), "predationInterval", 1u, 50u },
+        { ComponentRegistry::AttributeType::UINT32, offsetof(GAComponent, recordMode), "recordMode", {}, {}, {}, 
+            {"Best robot", "All robots", "Disabled"} },
 
         { ComponentRegistry::AttributeType::UINT32, offsetof(GAComponent, currGen), "currGen", 1u, 1000u },
         { ComponentRegistry::AttributeType::UINT32, offsetof(GAComponent, currEval), "currEval", 1u, 50u },
@@ -0,0 +1,36 @@
+//--------------------------------------------------
+// Genetic Algorithm 2D
+// coverageGrid.h
+// Date: 2026-10-19
+// By agent
+//--------------------------------------------------
+#ifndef COVERAGE_GRID_H
+#define COVERAGE_GRID_H
+#include <bitset>
+
+// Occupancy grid of the arena [-worldSize, worldSize]², one bit per cell
+// Cells are marked each tick and the coverage is only counted (popcount) when the evaluation ends
+struct CoverageGrid
+{
+    static constexpr unsigned size = 32;// Number of cells in each axis (32x32 cells -> 128 bytes per robot)
+
+    std::bitset<size*size> cells;
+
+    void clear() { cells.reset(); }
+
+    void mark(float x, float y, float worldSize)
+    {
+        // Map [-worldSize, worldSize] to [0, size) and clamp to the border cells
+        const float scale = size/(2*worldSize);
+        int cx = int((x+worldSize)*scale);
+        int cy = int((y+worldSize)*scale);
+        cx = cx < 0 ? 0 : (cx >= int(size) ? size-1 : cx);
+        cy = cy < 0 ? 0 : (cy >= int(size) ? size-1 : cy);
+        cells[cy*size + cx] = true;
+    }
+
+    // Fraction of the arena visited ∈ [0, 1]
+    float coverage() const { return cells.count()/float(size*size); }
+};
+
+#endif// COVERAGE_GRID_H
@@ -9,14 +9,15 @@
 #include <atta/pch.h>
 #include <atta/componentSystem/components/component.h>
 #include <atta/componentSystem/componentRegistry.h>
+#include "simulation.h"
 using namespace atta;
 
 struct GeneComponent final : public Component
 {  
-    static constexpr float maxLinearVelocity = 3.0f;
-    static constexpr float maxAngularVelocity = 2*M_PI;
-    static constexpr unsigned numSensors = 5;
-    static constexpr float maxRange = 2.0f;
+    static constexpr float maxLinearVelocity = simulation::Gene::maxLinearVelocity;
+    static constexpr float maxAngularVelocity = simulation::Gene::maxAngularVelocity;
+    static constexpr unsigned numSensors = simulation::Gene::numSensors;
+    static constexpr float maxRange = simulation::Gene::maxRange;
 
     float fitness;
 
@@ -26,6 +27,32 @@ struct GeneComponent final : public Component
     float sensorAngle[numSensors];// Angle for each sensor in radians (sensorAngle ∈ [0, 2π])
     float sensorRange[numSensors];// Maximum distance to trigger the sensor
     float sensorAction[numSensors];// If the sensor i was trigged, rotate by sensorAction[i]*angularVelocity[i]*dt (sensorAction ∈ [-1.0f,1.0f])
+
+    simulation::Gene toGene() const
+    {
+        simulation::Gene g;
+        g.linearVelocity = linearVelocity;
+        g.angularVelocity = angularVelocity;
+        for(unsigned i = 0; i < numSensors; i++)
+        {
+            g.sensorAngle[i] = sensorAngle[i];
+            g.sensorRange[i] = sensorRange[i];
+            g.sensorAction[i] = sensorAction[i];
+        }
+        return g;
+    }
+
+    void fromGene(const simulation::Gene& g)
+    {
+        linearVelocity = g.linearVelocity;
+        angularVelocity = g.angularVelocity;
+        for(unsigned i = 0; i < numSensors; i++)
+        {
+            sensorAngle[i] = g.sensorAngle[i];
+            sensorRange[i] = g.sensorRange[i];
+            sensorAction[i] = g.sensorAction[i];
+        }
+    }
 }; 
 ATTA_REGISTER_COMPONENT(GeneComponent)
    
@@ -5,12 +5,12 @@
 // By Breno Cunha Queiroz
 //--------------------------------------------------
 #include "projectScript.h"
-#include "common.h"
 #include <atta/componentSystem/componentManager.h>
 #include <atta/componentSystem/components/transformComponent.h>
 #include "geneComponent.h"
 #include "GAComponent.h"
 #include <atta/graphicsSystem/drawer.h>
+#include <atta/fileSystem/fileManager.h>
 #include <imgui.h>
 using namespace atta;
 
@@ -21,7 +21,9 @@ using namespace atta;
 #define WORLD_SIZE 5
 
 Project::Project():
-    _maxIterationTime(10000), _currIterationTime(0), _running(false)
+    _maxIterationTime(10000), _currIterationTime(0), _running(false),
+    _scenarioRng(rand()), _geneRng(rand()),
+    _replayGen(0), _replayEval(0), _replayTime(0), _replaySpeed(1.0f), _replayPlaying(false), _replayActive(false)
 {
 
 }
@@ -29,6 +31,7 @@ Project::Project():
 void Project::onStart()
 {
 	LOG_DEBUG("Project", "onStart");
+    stopReplay();
 
     _running = true;
     // Reset GA component
@@ -42,9 +45,13 @@ void Project::onStart()
     ga->robotFitness.clear();
     ga->robotFitness.push_back(std::vector<float>(factory->getMaxClones()));
 
-    randomizeObstacles();
-    randomizeRobotsPositions();
+    randomizeScenario();
     randomizeRobotsGenes();
+
+    // Start recording (or later, when recordMode is changed during the run)
+    _recorder.stop();
+    if(ga->recordMode != 2)
+        startRecording();
 }
 
 void Project::onStop()
@@ -52,6 +59,11 @@ void Project::onStop()
 	LOG_DEBUG("Project", "onStop");
     Drawer::clear<Drawer::Line>(StringId("robotSensor"));
     _running = false;
+
+    // The prepared scenario was created for this run's factories, which can be edited before the next run
+    if(_nextScenario.valid())
+        _nextScenario.wait();
+    _nextScenario = {};
 }
 
 void Project::onUpdateBefore(float delta)
@@ -63,16 +75,28 @@ void Project::onUpdateAfter(float delta)
 {
     GAComponent* ga = ComponentManager::getEntityComponent<GAComponent>(GA_EID);
 
-    updateRobotsBounds();
+    if(ga->fitnessType == 0)
+        updateRobotsBounds();
+    else
+        updateRobotsCoverage();
+
+    if(ga->recordMode != 2)
+    {
+        if(!_recorder.isStarted())
+            startRecording();
+        recordRobotsPoses();
+    }
 
     ga->currEvalTime += delta;
     if(ga->currEvalTime > ga->maxEvalTime)
     {
         // Finished one evaluation
+        _recorder.endEvaluation(ga->currEvalTime);
         ga->currEvalTime = 0;
         updateRobotsFitness();
-        randomizeObstacles();
-        randomizeRobotsPositions();
+
+        // Obstacles and robot positions prepared in background during the last evaluation
+        randomizeScenario();
 
         ga->currEval++;
         if(ga->currEval > ga->evalsPerGen)
@@ -80,46 +104,46 @@ void Project::onUpdateAfter(float delta)
             // Finished also one generation
             ga->currEval = 1;
 
-            // Calculate best robot
-            EntityId bestRobot = -1;
-            float bestFitness = 0;
-            for(unsigned i = 0; i < ga->robotFitness.back().size(); i++)
+            // Calculate best robot (same selection as the headless sweep)
+            float bestFitness;
+            EntityId bestRobot = simulation::bestRobot(ga->robotFitness, ga->crossingType, ga->fitnessSmooth, bestFitness);
+            LOG_SUCCESS("Project", "Generation finished, the best robot was [w]$0[], with fitness of [w]$1[]", 11+bestRobot, bestFitness);
+
+            // Save trajectories of this generation
+            if(_recorder.skippedEvaluations() > 0)
+                LOG_WARN("Project", "Trajectory buffer full, [w]$0[] evaluations of generation [w]$1[] were not recorded", _recorder.skippedEvaluations(), ga->currGen);
+            if(ga->recordMode == 0)
+                _recorder.writeGeneration(ga->currGen, { unsigned(bestRobot) });
+            else if(ga->recordMode == 1)
             {
-                unsigned numValues = ga->crossingType == 0 ? ga->fitnessSmooth : 1;
-
-                // Calculate mean
-                float mean = 0;
-                int qty = 0;
-                for(unsigned j = std::max(unsigned(ga->robotFitness.size()-numValues), 0u); j < ga->robotFitness.size(); j++)
-                {
-                    mean = (mean*qty + ga->robotFitness[j][i])/float(qty+1);
-                    qty++;
-                    if(i == 0)
-                        LOG_DEBUG("Project", "j: $0, mean: $1", j, mean);
-                }
-
-                if(mean >= bestFitness)
-                {
-                    bestRobot = EntityId(i);
-                    bestFitness = mean;
-                }
+                std::vector<unsigned> robots(ga->robotFitness.back().size());
+                for(unsigned i = 0; i < robots.size(); i++)
+                    robots[i] = i;
+                _recorder.writeGeneration(ga->currGen, robots);
             }
-            LOG_SUCCESS("Project", "Generation finished, the best robot was [w]$0[], with fitness of [w]$1[]", 11+bestRobot, bestFitness);
+            else
+                _recorder.discardGeneration();
 
             // Crossing and mutation
-            crossRobots(bestRobot);
-            mutateRobots(bestRobot);
+            stageNextGeneration(bestRobot);
+            commitNextGeneration();
 
             // Add data to next generation
             Factory* factory = ComponentManager::getPrototypeFactory(ROBOT_PROTOTYPE_EID);
-            ga->robotFitness.push_back(std::vector<float>(factory->getMaxClones()));
+            ga->robotFitness.emplace_back(factory->getMaxClones());
             ga->currGen++;
         }
+
+        if(ga->recordMode != 2 && _recorder.isStarted())
+            beginRecordingEvaluation();
     }
 }
 
 void Project::onAttaLoop()
 {
+    if(!_running && _replayActive)
+        updateReplay();
+
     // Clear robot sensor lines
     Drawer::clear<Drawer::Line>(StringId("robotSensor"));
 
@@ -147,44 +171,99 @@ void Project::onAttaLoop()
     }
 }
 
-void Project::randomizeObstacles()
+void Project::randomizeScenario()
 {
-    // For each obstacle
+    // Scenario is prepared synchronously only if there is no previous one (first evaluation)
+    if(!_nextScenario.valid())
+        prepareNextScenario();
+    std::optional<simulation::Scenario> scenario = _nextScenario.get();
+
+    // Prepare it again if the number of obstacles or robots changed after it was prepared
+    if(scenario &&
+        (scenario->obstacles.size() != ComponentManager::getPrototypeFactory(OBSTACLE_PROTOTYPE_EID)->getCloneIds().size() ||
+        scenario->robots.size() != ComponentManager::getPrototypeFactory(ROBOT_PROTOTYPE_EID)->getCloneIds().size()))
+    {
+        prepareNextScenario();
+        scenario = _nextScenario.get();
+    }
+
+    if(scenario)
+        applyScenario(*scenario);
+    else
+        LOG_ERROR("Project", "Could not place the robots without collisions after [w]$0[] attempts, keeping the current positions", simulation::maxSpawnAttempts);
+    resetRobotsExploration();
+
+    // Prepare the next evaluation while this one runs
+    prepareNextScenario();
+}
+
+void Project::prepareNextScenario()
+{
+    // The scenario thread only works with this snapshot, it never accesses the components
+    Factory* factory = ComponentManager::getPrototypeFactory(OBSTACLE_PROTOTYPE_EID);
+    unsigned numObstacles = factory->getCloneIds().size();
+    std::vector<float> robotRadii;
+    factory = ComponentManager::getPrototypeFactory(ROBOT_PROTOTYPE_EID);
+    for(EntityId robot : factory->getCloneIds())
+        robotRadii.push_back(ComponentManager::getEntityComponent<TransformComponent>(robot)->scale.x/2.0f);
+
+    _nextScenario = std::async(std::launch::async, [this, numObstacles, robotRadii]()
+        {
+            simulation::Scenario scenario;
+            if(!simulation::randomScenario(_scenarioRng, numObstacles, robotRadii, scenario))
+                return std::optional<simulation::Scenario>();
+            return std::optional<simulation::Scenario>(scenario);
+        });
+}
+
+void Project::applyScenario(const simulation::Scenario& scenario)
+{
+    // Obstacles
     Factory* factory = ComponentManager::getPrototypeFactory(OBSTACLE_PROTOTYPE_EID);
-    for(EntityId obstacle :  factory->getCloneIds())
+    unsigned i = 0;
+    for(EntityId obstacle : factory->getCloneIds())
     {
+        if(i >= scenario.obstacles.size())
+            break;
         TransformComponent* t = ComponentManager::getEntityComponent<TransformComponent>(obstacle);
-        t->position.x = (rand()%8000/1000.0f)-4.0f;
-        t->position.y = (rand()%8000/1000.0f)-4.0f;
+        t->position.x = scenario.obstacles[i].x;
+        t->position.y = scenario.obstacles[i].y;
+        t->scale.x = scenario.obstacles[i].radius*2.0f;
+        t->scale.y = scenario.obstacles[i].radius*2.0f;
+        i++;
+    }
 
-        float scale = (rand()%1000/1000.0f)+0.3f;
-        t->scale.x = scale;
-        t->scale.y = scale;
+    // Robots
+    factory = ComponentManager::getPrototypeFactory(ROBOT_PROTOTYPE_EID);
+    i = 0;
+    for(EntityId robot :  factory->getCloneIds())
+    {
+        if(i >= scenario.robots.size())
+            break;
+        TransformComponent* t = ComponentManager::getEntityComponent<TransformComponent>(robot);
+        t->position.x = scenario.robots[i].x;
+        t->position.y = scenario.robots[i].y;
+        t->orientation.rotateAroundAxis(vec3(0,0,1), scenario.robotAngles[i]);
+        i++;
     }
 }
 
-void Project::randomizeRobotsPositions()
+void Project::resetRobotsExploration()
 {
-    Factory* factory = ComponentManager::getPrototypeFactory(ROBOT_PROTOTYPE_EID);
-
     // Reset bound vector
+    Factory* factory = ComponentManager::getPrototypeFactory(ROBOT_PROTOTYPE_EID);
     GAComponent* ga = ComponentManager::getEntityComponent<GAComponent>(GA_EID);
     ga->robotBounds.resize(factory->getMaxClones());
+    ga->robotCoverage.resize(factory->getMaxClones());
 
-    // For each robot
     unsigned i = 0;
     for(EntityId robot :  factory->getCloneIds())
     {
         TransformComponent* t = ComponentManager::getEntityComponent<TransformComponent>(robot);
-        do
-        {
-            t->position.x = (rand()%8000/1000.0f)-4.0f;
-            t->position.y = (rand()%8000/1000.0f)-4.0f;
-            t->orientation.rotateAroundAxis(vec3(0,0,1), 2*(rand()%314/314.0f));
-        } while(common::isInCollision(robot, t));
-
         ga->robotBounds[i].pMin = pnt2(t->position.x, t->position.y);
         ga->robotBounds[i].pMax = pnt2(t->position.x, t->position.y);
+        ga->robotCoverage[i].clear();
+        ga->robotCoverage[i].mark(t->position.x, t->position.y, WORLD_SIZE);
         i++;
     }
 }
@@ -221,85 +300,67 @@ void Project::updateRobotsBounds()
     }
 }
 
-void Project::updateRobotsFitness()
+void Project::updateRobotsCoverage()
 {
     Factory* factory = ComponentManager::getPrototypeFactory(ROBOT_PROTOTYPE_EID);
     GAComponent* ga = ComponentManager::getEntityComponent<GAComponent>(GA_EID);
     unsigned i = 0;
     for(EntityId robot : factory->getCloneIds())
     {
-        float x = ga->robotBounds[i].pMax.x -ga->robotBounds[i].pMin.x;
-        float y = ga->robotBounds[i].pMax.y -ga->robotBounds[i].pMin.y;
-        float fitness = x*y/((WORLD_SIZE*2)*(WORLD_SIZE*2));
-
-        ga->robotFitness.back()[i] = ((ga->robotFitness.back()[i]*(ga->currEval-1))+fitness)/float(ga->currEval);
+        TransformComponent* t = ComponentManager::getEntityComponent<TransformComponent>(robot);
+        ga->robotCoverage[i].mark(t->position.x, t->position.y, WORLD_SIZE);
         i++;
     }
 }
 
-void Project::crossRobots(EntityId bestRobot)
+void Project::updateRobotsFitness()
 {
     Factory* factory = ComponentManager::getPrototypeFactory(ROBOT_PROTOTYPE_EID);
     GAComponent* ga = ComponentManager::getEntityComponent<GAComponent>(GA_EID);
-
-    GeneComponent* bestGene = ComponentManager::getEntityComponent<GeneComponent>(factory->getFirstCloneId()+bestRobot);
-
-    unsigned i = -1;
+    unsigned i = 0;
     for(EntityId robot : factory->getCloneIds())
     {
-        i++;
-        if(robot == bestRobot)
-            continue;
-
-        GeneComponent* gene = ComponentManager::getEntityComponent<GeneComponent>(robot);
-
-        gene->linearVelocity = (gene->linearVelocity+bestGene->linearVelocity)/2.0f;
-        gene->angularVelocity = (gene->angularVelocity+bestGene->angularVelocity)/2.0f;
-        for(unsigned i = 0; i < GeneComponent::numSensors; i++)
+        float fitness;
+        if(ga->fitnessType == 0)
         {
-            gene->sensorAngle[i] = common::angleAverage(gene->sensorAngle[i], bestGene->sensorAngle[i]);
-            gene->sensorRange[i] = (gene->sensorRange[i]+bestGene->sensorRange[i])/2.0f;
-            gene->sensorAction[i] = (gene->sensorAction[i]+bestGene->sensorAction[i])/2.0f;
+            // Area of the bounding box explored
+            float x = ga->robotBounds[i].pMax.x -ga->robotBounds[i].pMin.x;
+            float y = ga->robotBounds[i].pMax.y -ga->robotBounds[i].pMin.y;
+            fitness = x*y/((WORLD_SIZE*2)*(WORLD_SIZE*2));
         }
+        else
+            fitness = ga->robotCoverage[i].coverage();// Fraction of the grid cells visited
+
+        ga->robotFitness.back()[i] = ((ga->robotFitness.back()[i]*(ga->currEval-1))+fitness)/float(ga->currEval);
+        i++;
     }
 }
 
-void Project::mutateRobots(EntityId bestRobot)
+void Project::stageNextGeneration(EntityId bestRobot)
 {
     Factory* factory = ComponentManager::getPrototypeFactory(ROBOT_PROTOTYPE_EID);
     GAComponent* ga = ComponentManager::getEntityComponent<GAComponent>(GA_EID);
 
-    unsigned i = -1;
+    // Snapshot of the current genes
+    std::vector<simulation::Gene> genes;
     for(EntityId robot : factory->getCloneIds())
-    {
-        i++;
-        if(robot == bestRobot)
-            continue;
+        genes.push_back(ComponentManager::getEntityComponent<GeneComponent>(robot)->toGene());
 
-        if((rand()%1000/1000.0f) <= ga->mutationRate)
-        {
-            // Create randomGene
-            GeneComponent randomGene;
-            randomGene.linearVelocity = rand()%1000/1000.0f*GeneComponent::maxLinearVelocity;
-            randomGene.angularVelocity = rand()%1000/1000.0f*GeneComponent::maxAngularVelocity;
-            for(unsigned i = 0; i < GeneComponent::numSensors; i++)
-            {
-                randomGene.sensorAngle[i] = (rand()%1000/1000.0f)*2*M_PI;
-                randomGene.sensorRange[i] = rand()%1000/1000.0f*GeneComponent::maxRange;
-                randomGene.sensorAction[i] = (rand()%2000/1000.0f) - 1.0f;
-            }
+    _stagedGenes = simulation::nextGeneration(genes, bestRobot, ga->mutationRate, _geneRng);
+}
 
-            // Mutate robot with random gene
-            GeneComponent* gene = ComponentManager::getEntityComponent<GeneComponent>(robot);
-            gene->linearVelocity = (gene->linearVelocity+randomGene.linearVelocity)/2.0f;
-            gene->angularVelocity = (gene->angularVelocity+randomGene.angularVelocity)/2.0f;
-            for(unsigned i = 0; i < GeneComponent::numSensors; i++)
-            {
-                gene->sensorAngle[i] = common::angleAverage(gene->sensorAngle[i], randomGene.sensorAngle[i]);
-                gene->sensorRange[i] = (gene->sensorRange[i]+randomGene.sensorRange[i])/2.0f;
-                gene->sensorAction[i] = (gene->sensorAction[i]+randomGene.sensorAction[i])/2.0f;
-            }
-        }
+void Project::commitNextGeneration()
+{
+    // Copy all staged genes at once, the robots never see a partially updated generation
+    const std::vector<simulation::Gene>& genes = _stagedGenes;
+    Factory* factory = ComponentManager::getPrototypeFactory(ROBOT_PROTOTYPE_EID);
+    unsigned i = 0;
+    for(EntityId robot : factory->getCloneIds())
+    {
+        if(i >= genes.size())
+            break;
+        ComponentManager::getEntityComponent<GeneComponent>(robot)->fromGene(genes[i]);
+        i++;
     }
 }
 
@@ -324,5 +385,161 @@ void Project::onUIRender()
             0, NULL, 0.0f, 1.0f, ImVec2(1500.0f, 120.0f));
 
     }
+    renderReplayUI();
     ImGui::End();
 }
+
+std::string Project::trajectoryFile() const
+{
+    return (FileManager::getProject()->getDirectory()/"trajectories.gatr").string();
+}
+
+void Project::startRecording()
+{
+    Factory* factory = ComponentManager::getPrototypeFactory(ROBOT_PROTOTYPE_EID);
+    if(!_recorder.start(trajectoryFile(), factory->getMaxClones()))
+        LOG_WARN("Project", "Could not create trajectory file [w]$0[]", trajectoryFile());
+    beginRecordingEvaluation();
+}
+
+void Project::beginRecordingEvaluation()
+{
+    std::vector<trajectory::Obstacle> obstacles;
+    Factory* factory = ComponentManager::getPrototypeFactory(OBSTACLE_PROTOTYPE_EID);
+    for(EntityId obstacle : factory->getCloneIds())
+    {
+        TransformComponent* t = ComponentManager::getEntityComponent<TransformComponent>(obstacle);
+        obstacles.push_back({ t->position.x, t->position.y, t->scale.x });
+    }
+    _recorder.beginEvaluation(obstacles);
+}
+
+void Project::recordRobotsPoses()
+{
+    Factory* factory = ComponentManager::getPrototypeFactory(ROBOT_PROTOTYPE_EID);
+    unsigned i = 0;
+    for(EntityId robot : factory->getCloneIds())
+    {
+        TransformComponent* t = ComponentManager::getEntityComponent<TransformComponent>(robot);
+        _recorder.record(i, { t->position.x, t->position.y, t->orientation.toEuler().z });
+        i++;
+    }
+}
+
+void Project::startReplay()
+{
+    // Save the scene to restore it when the replay stops
+    _replaySavedTransforms.clear();
+    for(EntityId prototype : { OBSTACLE_PROTOTYPE_EID, ROBOT_PROTOTYPE_EID })
+        for(EntityId eid : ComponentManager::getPrototypeFactory(prototype)->getCloneIds())
+            _replaySavedTransforms.push_back({ eid, *ComponentManager::getEntityComponent<TransformComponent>(eid) });
+    _replayLastTime = std::chrono::steady_clock::now();
+    _replayActive = true;
+}
+
+void Project::stopReplay()
+{
+    if(!_replayActive)
+        return;
+    for(auto& [eid, transform] : _replaySavedTransforms)
+        *ComponentManager::getEntityComponent<TransformComponent>(eid) = transform;
+    _replaySavedTransforms.clear();
+    _replayActive = false;
+    _replayPlaying = false;
+}
+
+void Project::updateReplay()
+{
+    if(_replayPoses.empty())
+        return;
+
+    // Advance replay time (wall clock, no simulation)
+    auto now = std::chrono::steady_clock::now();
+    float dt = std::chrono::duration<float>(now - _replayLastTime).count();
+    _replayLastTime = now;
+    const trajectory::Evaluation& eval = _replayGenerations[_replayGen].evals[_replayEval];
+    if(eval.duration <= 0)
+        return;
+    if(_replayPlaying)
+        _replayTime = std::min(_replayTime + dt*_replaySpeed, eval.duration);
+
+    // Obstacles
+    Factory* factory = ComponentManager::getPrototypeFactory(OBSTACLE_PROTOTYPE_EID);
+    unsigned i = 0;
+    for(EntityId obstacle : factory->getCloneIds())
+    {
+        if(i >= eval.obstacles.size())
+            break;
+        TransformComponent* t = ComponentManager::getEntityComponent<TransformComponent>(obstacle);
+        t->position.x = eval.obstacles[i].x;
+        t->position.y = eval.obstacles[i].y;
+        t->scale.x = eval.obstacles[i].scale;
+        t->scale.y = eval.obstacles[i].scale;
+        i++;
+    }
+
+    // Recorded robots
+    factory = ComponentManager::getPrototypeFactory(ROBOT_PROTOTYPE_EID);
+    for(unsigned j = 0; j < eval.tracks.size(); j++)
+    {
+        const std::vector<trajectory::Pose>& poses = _replayPoses[j];
+        if(poses.empty() || eval.tracks[j].robot >= factory->getMaxClones())
+            continue;
+        unsigned sample = std::min(unsigned(_replayTime/eval.duration*poses.size()), unsigned(poses.size()-1));
+
+        TransformComponent* t = ComponentManager::getEntityComponent<TransformComponent>(factory->getFirstCloneId()+eval.tracks[j].robot);
+        t->position.x = poses[sample].x;
+        t->position.y = poses[sample].y;
+        t->orientation.setEuler(vec3(0, 0, poses[sample].angle));
+    }
+}
+
+void Project::renderReplayUI()
+{
+    if(!ImGui::CollapsingHeader("Replay"))
+        return;
+
+    if(ImGui::Button("Load trajectories"))
+    {
+        stopReplay();
+        _replayPoses.clear();
+        if(!trajectory::load(trajectoryFile(), _replayGenerations))
+            LOG_WARN("Project", "Could not load trajectory file [w]$0[]", trajectoryFile());
+        _replayGen = _replayEval = 0;
+    }
+    if(_replayGenerations.empty())
+        return;
+
+    bool changed = _replayPoses.empty();
+    changed |= ImGui::SliderInt("Generation", &_replayGen, 0, _replayGenerations.size()-1);
+    _replayGen = std::clamp(_replayGen, 0, int(_replayGenerations.size())-1);
+    const trajectory::Generation& generation = _replayGenerations[_replayGen];
+    if(generation.evals.empty())
+        return;
+    ImGui::Text("Recorded generation: %u", generation.gen);
+    changed |= ImGui::SliderInt("Evaluation", &_replayEval, 0, generation.evals.size()-1);
+    _replayEval = std::clamp(_replayEval, 0, int(generation.evals.size())-1);
+
+    if(changed)
+    {
+        // Decode selected evaluation
+        _replayPoses.clear();
+        for(const trajectory::Track& track : generation.evals[_replayEval].tracks)
+            _replayPoses.push_back(track.decode());
+        _replayTime = 0;
+        _replayLastTime = std::chrono::steady_clock::now();
+    }
+
+    bool active = _replayActive;
+    if(ImGui::Checkbox("Replay", &active) && !_running)
+    {
+        if(active)
+            startReplay();
+        else
+            stopReplay();
+    }
+    ImGui::SameLine();
+    ImGui::Checkbox("Play", &_replayPlaying);
+    ImGui::SliderFloat("Speed", &_replaySpeed, 0.1f, 20.0f);
+    ImGui::SliderFloat("Time", &_replayTime, 0.0f, generation.evals[_replayEval].duration);
+}
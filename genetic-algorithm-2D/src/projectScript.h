@@ -9,6 +9,12 @@
 #include <atta/pch.h>
 #include <atta/scriptSystem/projectScript.h>
 #include <atta/componentSystem/base.h>
+#include <atta/componentSystem/components/transformComponent.h>
+#include "trajectoryRecorder.h"
+#include "simulation.h"
+#include <chrono>
+#include <future>
+#include <optional>
 
 class Project : public atta::ProjectScript
 {
@@ -24,17 +30,48 @@ public:
 
     void onAttaLoop() override;
 private:
-    void randomizeObstacles();
-    void randomizeRobotsPositions();
+    void randomizeScenario();
+    void prepareNextScenario();
+    void applyScenario(const simulation::Scenario& scenario);
+    void resetRobotsExploration();
     void randomizeRobotsGenes();
     void updateRobotsBounds();
+    void updateRobotsCoverage();
     void updateRobotsFitness();
-    void crossRobots(atta::EntityId bestRobot);
-    void mutateRobots(atta::EntityId bestRobot);
+    void stageNextGeneration(atta::EntityId bestRobot);
+    void commitNextGeneration();
+
+    // Trajectory recording/replay
+    std::string trajectoryFile() const;
+    void startRecording();
+    void beginRecordingEvaluation();
+    void recordRobotsPoses();
+    void startReplay();
+    void stopReplay();
+    void updateReplay();
+    void renderReplayUI();
 
     const float _maxIterationTime;
     float _currIterationTime;
     bool _running;
+
+    // Generation transitions
+    std::mt19937 _scenarioRng;// Only used by the scenario thread
+    std::mt19937 _geneRng;// Crossing and mutation
+    std::future<std::optional<simulation::Scenario>> _nextScenario;// Obstacle layout and spawn poses of the next evaluation, prepared in background
+    std::vector<simulation::Gene> _stagedGenes;// Genes of the next generation, committed to all robots at once
+
+    trajectory::Recorder _recorder;
+    std::vector<trajectory::Generation> _replayGenerations;
+    std::vector<std::vector<trajectory::Pose>> _replayPoses;// Decoded poses of each track of the selected evaluation
+    int _replayGen;
+    int _replayEval;
+    float _replayTime;// Time inside the evaluation in seconds
+    float _replaySpeed;
+    bool _replayPlaying;
+    bool _replayActive;// Replay drives the transforms only while active
+    std::vector<std::pair<atta::EntityId, atta::TransformComponent>> _replaySavedTransforms;// Scene before the replay started
+    std::chrono::steady_clock::time_point _replayLastTime;
 };
 
 ATTA_REGISTER_PROJECT_SCRIPT(Project)
@@ -15,9 +15,6 @@ class RobotScript : public atta::Script
 {
 public:
     void update(atta::Entity entity, float dt) override;
-
-private:
-    float sensorActionResult(atta::EntityId eid, atta::TransformComponent* t, GeneComponent* g);
 };
 
 ATTA_REGISTER_SCRIPT(RobotScript)
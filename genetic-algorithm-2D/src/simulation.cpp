@@ -0,0 +1,368 @@
+//--------------------------------------------------
+// Genetic Algorithm 2D
+// simulation.cpp
+// Date: 2026-10-19
+// By agent
+//--------------------------------------------------
+#include "simulation.h"
+#include "coverageGrid.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace simulation
+{
+    namespace
+    {
+        float uniform(std::mt19937& rng, float min, float max)
+        {
+            return std::uniform_real_distribution<float>(min, max)(rng);
+        }
+
+        bool outsideWorld(const Disc& d)
+        {
+            return d.x > worldSize-d.radius || d.x < -worldSize+d.radius ||
+                d.y > worldSize-d.radius || d.y < -worldSize+d.radius;
+        }
+
+        bool collides(const Disc& a, const Disc& b)
+        {
+            float dx = a.x-b.x;
+            float dy = a.y-b.y;
+            return std::sqrt(dx*dx + dy*dy) <= a.radius+b.radius;
+        }
+
+        Gene randomGene(std::mt19937& rng)
+        {
+            Gene gene;
+            gene.linearVelocity = uniform(rng, 0.0f, Gene::maxLinearVelocity);
+            gene.angularVelocity = uniform(rng, 0.0f, Gene::maxAngularVelocity);
+            for(unsigned i = 0; i < Gene::numSensors; i++)
+            {
+                gene.sensorAngle[i] = uniform(rng, 0.0f, 2*M_PI);
+                gene.sensorRange[i] = uniform(rng, 0.0f, Gene::maxRange);
+                gene.sensorAction[i] = uniform(rng, -1.0f, 1.0f);
+            }
+            return gene;
+        }
+
+        void averageGene(Gene& gene, const Gene& other)
+        {
+            gene.linearVelocity = (gene.linearVelocity+other.linearVelocity)/2.0f;
+            gene.angularVelocity = (gene.angularVelocity+other.angularVelocity)/2.0f;
+            for(unsigned i = 0; i < Gene::numSensors; i++)
+            {
+                gene.sensorAngle[i] = angleAverage(gene.sensorAngle[i], other.sensorAngle[i]);
+                gene.sensorRange[i] = (gene.sensorRange[i]+other.sensorRange[i])/2.0f;
+                gene.sensorAction[i] = (gene.sensorAction[i]+other.sensorAction[i])/2.0f;
+            }
+        }
+
+        // Robots updated one after the other, as atta does with RobotScript
+        class World
+        {
+        public:
+            World(const std::vector<Robot>& robots, const std::vector<Disc>& obstacles)
+            {
+                _env.obstacles = obstacles;
+                for(const Robot& robot : robots)
+                {
+                    _env.robots.push_back(robot.disc);
+                    _angles.push_back(robot.angle);
+                    _genes.push_back(robot.gene);
+                }
+            }
+
+            void step(float dt)
+            {
+                for(unsigned i = 0; i < _env.robots.size(); i++)
+                {
+                    _env.ignore = i;
+                    Disc d = _env.robots[i];
+                    // The script rotates the transform, which has the inverted angle
+                    _angles[i] -= updateRobot(d, _angles[i], _genes[i], _env, dt);
+                    _env.robots[i] = d;
+                }
+            }
+
+            const Disc& robot(unsigned i) const { return _env.robots[i]; }
+
+        private:
+            Environment _env;
+            std::vector<float> _angles;
+            std::vector<Gene> _genes;
+        };
+    }
+
+    float angleAverage(float angle0, float angle1)
+    {
+        float a = std::min(angle0, angle1);
+        float b = std::max(angle0, angle1);
+        if(b-a < M_PI)
+            return (b+a)/2.0f;
+        else
+        {
+            float res = (a+2*M_PI+b)/2.0f;
+            if(res >= 2*M_PI)
+                res -= 2*M_PI;
+            return res;
+        }
+    }
+
+    bool isInCollision(const Disc& d, const Environment& env)
+    {
+        if(outsideWorld(d))
+            return true;
+        for(const Disc& obstacle : env.obstacles)
+            if(collides(d, obstacle))
+                return true;
+        for(unsigned i = 0; i < env.robots.size(); i++)
+            if(int(i) != env.ignore && collides(d, env.robots[i]))
+                return true;
+        return false;
+    }
+
+    float sensorActionResult(const Disc& robot, float angle, const Gene& g, const Environment& env)
+    {
+        float result = 0;
+        for(unsigned i = 0; i < Gene::numSensors; i++)
+        {
+            float sensorAngle = angle+g.sensorAngle[i];
+            float lx = std::cos(sensorAngle);
+            float ly = std::sin(sensorAngle);
+            float sx = robot.x+lx*g.sensorRange[i];
+            float sy = robot.y+ly*g.sensorRange[i];
+
+            // Check if sensor detected a wall
+            bool sensorActivated = sx <= -worldSize || sx >= worldSize || sy <= -worldSize || sy >= worldSize;
+
+            // Check if sensor detected obstacle or robot
+            auto detect = [&](const Disc& o)
+            {
+                float cx = o.x-robot.x;
+                float cy = o.y-robot.y;
+                float cLength = std::sqrt(cx*cx + cy*cy);
+                double d = (cx*lx + cy*ly)/cLength;
+                float dx = cLength*d;
+                float dy = cLength*std::sqrt(1.0 - d*d);
+                float ex = sx-o.x;
+                float ey = sy-o.y;
+                return (dx <= g.sensorRange[i] && dx >= 0 && dy <= o.radius) ||// Line distance
+                    (dx >= g.sensorRange[i] && std::sqrt(ex*ex + ey*ey) <= o.radius);// End point distance
+            };
+            for(unsigned j = 0; !sensorActivated && j < env.obstacles.size(); j++)
+                sensorActivated = detect(env.obstacles[j]);
+            for(unsigned j = 0; !sensorActivated && j < env.robots.size(); j++)
+                sensorActivated = int(j) != env.ignore && detect(env.robots[j]);
+
+            if(sensorActivated)
+                result -= g.sensorAction[i]*g.angularVelocity;
+        }
+        return result;
+    }
+
+    float updateRobot(Disc& robot, float angle, const Gene& gene, const Environment& env, float dt)
+    {
+        //----- Update position -----//
+        float speed = gene.linearVelocity*dt;
+        float dx = std::cos(angle)*speed;
+        float dy = std::sin(angle)*speed;
+        robot.x += dx;
+        robot.y += dy;
+
+        // Solve collision
+        if(isInCollision(robot, env))
+        {
+            robot.x -= dx;
+            robot.y -= dy;
+        }
+
+        //----- Update sensor -----//
+        return sensorActionResult(robot, angle, gene, env);
+    }
+
+    bool randomScenario(std::mt19937& rng, unsigned numObstacles, const std::vector<float>& robotRadii, Scenario& scenario)
+    {
+        scenario = Scenario();
+
+        // Quick reject, the robots alone would cover the whole spawn area (8x8)
+        float robotsArea = 0;
+        for(float radius : robotRadii)
+            robotsArea += M_PI*radius*radius;
+        if(robotsArea >= 8.0f*8.0f)
+            return false;
+
+        for(unsigned i = 0; i < numObstacles; i++)
+        {
+            float scale = uniform(rng, 0.3f, 1.3f);
+            scenario.obstacles.push_back({ uniform(rng, -4.0f, 4.0f), uniform(rng, -4.0f, 4.0f), scale/2.0f });
+        }
+
+        for(float radius : robotRadii)
+        {
+            Disc d { 0, 0, radius };
+            bool inCollision;
+            unsigned attempts = 0;
+            do
+            {
+                if(attempts++ == maxSpawnAttempts)
+                    return false;
+                d.x = uniform(rng, -4.0f, 4.0f);
+                d.y = uniform(rng, -4.0f, 4.0f);
+                inCollision = outsideWorld(d);
+                for(unsigned i = 0; !inCollision && i < scenario.obstacles.size(); i++)
+                    inCollision = collides(d, scenario.obstacles[i]);
+                for(unsigned i = 0; !inCollision && i < scenario.robots.size(); i++)
+                    inCollision = collides(d, scenario.robots[i]);
+            } while(inCollision);
+            scenario.robots.push_back(d);
+            scenario.robotAngles.push_back(uniform(rng, 0.0f, 2*M_PI));
+        }
+        return true;
+    }
+
+    unsigned bestRobot(const std::vector<std::vector<float>>& robotFitness, uint32_t crossingType, uint32_t fitnessSmooth, float& bestFitness)
+    {
+        unsigned best = 0;
+        bestFitness = 0;
+        if(robotFitness.empty())
+            return best;
+
+        unsigned numValues = crossingType == 0 ? fitnessSmooth : 1;
+        unsigned first = robotFitness.size() > numValues ? robotFitness.size()-numValues : 0;
+        for(unsigned i = 0; i < robotFitness.back().size(); i++)
+        {
+            float fitness = 0;
+            for(unsigned j = first; j < robotFitness.size(); j++)
+                fitness += robotFitness[j][i]/(robotFitness.size()-first);
+            if(fitness >= bestFitness)
+            {
+                best = i;
+                bestFitness = fitness;
+            }
+        }
+        return best;
+    }
+
+    std::vector<Gene> nextGeneration(const std::vector<Gene>& genes, unsigned bestRobot, float mutationRate, std::mt19937& rng)
+    {
+        std::vector<Gene> next = genes;
+        for(unsigned i = 0; i < next.size(); i++)
+        {
+            if(i == bestRobot)
+                continue;
+            averageGene(next[i], genes[bestRobot]);
+            if(uniform(rng, 0.0f, 1.0f) <= mutationRate)
+                averageGene(next[i], randomGene(rng));
+        }
+        return next;
+    }
+
+    Result run(const Parameters& p)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::mt19937 rng(p.seed);
+        Result result;
+        result.seconds = 0;
+        if(!(p.dt > 0))
+        {
+            result.error = "dt must be positive";// The evaluation would never end
+            return result;
+        }
+
+        std::vector<Robot> robots(p.numRobots);
+        std::vector<float> robotRadii(p.numRobots, p.robotSize/2.0f);
+        for(Robot& robot : robots)
+            robot.gene = randomGene(rng);
+
+        std::vector<std::vector<float>> robotFitness;// For each generation, fitness of each robot
+        std::vector<CoverageGrid> robotCoverage(p.numRobots);
+        std::vector<float> robotBounds(4*p.numRobots);// For each robot, min x, min y, max x, max y
+        for(unsigned gen = 0; gen < p.numGenerations; gen++)
+        {
+            robotFitness.push_back(std::vector<float>(p.numRobots));
+            for(unsigned eval = 1; eval <= p.evalsPerGen; eval++)
+            {
+                // Randomize obstacles and robot positions
+                Scenario scenario;
+                if(!randomScenario(rng, p.numObstacles, robotRadii, scenario))
+                {
+                    result.error = "could not place the robots without collisions";
+                    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+                    return result;
+                }
+                for(unsigned i = 0; i < p.numRobots; i++)
+                {
+                    robots[i].disc = scenario.robots[i];
+                    robots[i].angle = scenario.robotAngles[i];
+                    robotCoverage[i].clear();
+                    robotCoverage[i].mark(robots[i].disc.x, robots[i].disc.y, worldSize);
+                    float* b = &robotBounds[4*i];
+                    b[0] = b[2] = robots[i].disc.x;
+                    b[1] = b[3] = robots[i].disc.y;
+                }
+                World world(robots, scenario.obstacles);
+
+                // Evaluate
+                for(float evalTime = 0; evalTime <= p.maxEvalTime; evalTime += p.dt)
+                {
+                    world.step(p.dt);
+                    for(unsigned i = 0; i < p.numRobots; i++)
+                    {
+                        const Disc& d = world.robot(i);
+                        if(p.fitnessType == 0)
+                        {
+                            float* b = &robotBounds[4*i];
+                            b[0] = std::min(b[0], d.x);
+                            b[1] = std::min(b[1], d.y);
+                            b[2] = std::max(b[2], d.x);
+                            b[3] = std::max(b[3], d.y);
+                        }
+                        else
+                            robotCoverage[i].mark(d.x, d.y, worldSize);
+                    }
+                }
+
+                // Update fitness (mean over the evaluations)
+                for(unsigned i = 0; i < p.numRobots; i++)
+                {
+                    float fitness;
+                    if(p.fitnessType == 0)
+                    {
+                        const float* b = &robotBounds[4*i];
+                        fitness = (b[2]-b[0])*(b[3]-b[1])/((worldSize*2)*(worldSize*2));
+                    }
+                    else
+                        fitness = robotCoverage[i].coverage();
+                    robotFitness.back()[i] = (robotFitness.back()[i]*(eval-1) + fitness)/float(eval);
+                }
+            }
+
+            // Convergence
+            const std::vector<float>& genFitness = robotFitness.back();
+            float best = 0, mean = 0;
+            for(float fitness : genFitness)
+            {
+                best = std::max(best, fitness);
+                mean += fitness/genFitness.size();
+            }
+            result.bestFitness.push_back(best);
+            result.meanFitness.push_back(mean);
+
+            // Calculate best robot
+            float bestFitness;
+            unsigned bestRobotIndex = bestRobot(robotFitness, p.crossingType, p.fitnessSmooth, bestFitness);
+
+            // Crossing and mutation
+            std::vector<Gene> genes(p.numRobots);
+            for(unsigned i = 0; i < p.numRobots; i++)
+                genes[i] = robots[i].gene;
+            genes = nextGeneration(genes, bestRobotIndex, p.mutationRate, rng);
+            for(unsigned i = 0; i < p.numRobots; i++)
+                robots[i].gene = genes[i];
+        }
+
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+        return result;
+    }
+}
@@ -0,0 +1,123 @@
+//--------------------------------------------------
+// Genetic Algorithm 2D
+// simulation.h
+// Date: 2026-10-19
+// By agent
+//--------------------------------------------------
+#ifndef SIMULATION_H
+#define SIMULATION_H
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Robot model (movement, sensors, collisions) and GA operators without atta dependencies
+// The atta scripts (robotScript, projectScript) call these functions on views of their components, and
+// run() executes whole GAs headless, so many independent runs can be executed concurrently
+namespace simulation
+{
+    constexpr float worldSize = 5;// Same as WORLD_SIZE
+
+    // Genes and limits of each robot (GeneComponent uses the same limits)
+    struct Gene
+    {
+        static constexpr float maxLinearVelocity = 3.0f;
+        static constexpr float maxAngularVelocity = 2*M_PI;
+        static constexpr unsigned numSensors = 5;
+        static constexpr float maxRange = 2.0f;
+
+        float linearVelocity;
+        float angularVelocity;
+        float sensorAngle[numSensors];
+        float sensorRange[numSensors];
+        float sensorAction[numSensors];
+    };
+
+    struct Disc
+    {
+        float x, y;
+        float radius;
+    };
+
+    struct Robot
+    {
+        Disc disc;
+        float angle;// Orientation in radians
+        Gene gene;
+    };
+
+    // What a robot can collide with or sense
+    struct Environment
+    {
+        std::vector<Disc> obstacles;
+        std::vector<Disc> robots;
+        int ignore = -1;// Index in robots that is not considered (the robot itself), -1 if not in robots
+    };
+
+    float angleAverage(float angle0, float angle1);
+
+    // If d collides with a wall, obstacle or robot
+    bool isInCollision(const Disc& d, const Environment& env);
+
+    // Rotation given by the sensors that detected a wall, obstacle or robot
+    // angle is the robot orientation in radians (-euler.z of the TransformComponent)
+    float sensorActionResult(const Disc& robot, float angle, const Gene& gene, const Environment& env);
+
+    // Move the robot forward for dt seconds (the movement is undone if it collides) and return the rotation
+    // to apply around z (TransformComponent::orientation.rotateAroundAxis)
+    float updateRobot(Disc& robot, float angle, const Gene& gene, const Environment& env, float dt);
+
+    // Obstacle layout and robot spawn poses of one evaluation
+    struct Scenario
+    {
+        std::vector<Disc> obstacles;
+        std::vector<Disc> robots;
+        std::vector<float> robotAngles;
+    };
+
+    // Random obstacles and collision free robot positions, robots are checked against the already placed ones
+    // Returns false if some robot could not be placed after maxSpawnAttempts attempts (or if the robots cannot fit)
+    constexpr unsigned maxSpawnAttempts = 10000;
+    bool randomScenario(std::mt19937& rng, unsigned numObstacles, const std::vector<float>& robotRadii, Scenario& scenario);
+
+    // Index of the best robot, its fitness is the mean over the last fitnessSmooth generations when crossingType is 0
+    // and the fitness of the last generation otherwise. robotFitness has the fitness of each robot for each generation
+    unsigned bestRobot(const std::vector<std::vector<float>>& robotFitness, uint32_t crossingType, uint32_t fitnessSmooth, float& bestFitness);
+
+    // Genes of the next generation, every robot except the best one is crossed with the best robot
+    // and then mutated (averaged with a random gene) with probability mutationRate
+    std::vector<Gene> nextGeneration(const std::vector<Gene>& genes, unsigned bestRobot, float mutationRate, std::mt19937& rng);
+
+    struct Parameters
+    {
+        // GAComponent parameters
+        float mutationRate = 0.05f;
+        uint32_t crossingType = 0;
+        uint32_t fitnessSmooth = 1;
+        uint32_t evalsPerGen = 1;
+        float maxEvalTime = 10.0f;
+        uint32_t fitnessType = 0;
+
+        // World
+        uint32_t numGenerations = 50;
+        uint32_t numRobots = 20;
+        uint32_t numObstacles = 10;
+        float robotSize = 0.2f;// Robot diameter
+        float dt = 0.016f;// Simulation step in seconds
+        uint32_t seed = 0;
+    };
+
+    struct Result
+    {
+        std::vector<float> bestFitness;// Best robot fitness of each generation
+        std::vector<float> meanFitness;// Mean robot fitness of each generation
+        double seconds;// Wall-clock time of the run
+        std::string error;// Empty if the run finished
+    };
+
+    // Run a full genetic algorithm (numGenerations generations)
+    Result run(const Parameters& parameters);
+}
+
+#endif// SIMULATION_H
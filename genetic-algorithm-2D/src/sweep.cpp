@@ -0,0 +1,266 @@
+//--------------------------------------------------
+// Genetic Algorithm 2D
+// sweep.cpp
+// Date: 2026-10-19
+// By agent
+//--------------------------------------------------
+// Headless hyperparameter sweep, each combination of GA parameters is an independent run
+// executed by a pool of worker threads. Results are written to <out>_runs.csv and <out>_convergence.csv
+//
+// Each parameter accepts a list (0.01,0.05,0.1) or, with --random, a range (0.01:0.1)
+//   sweep --mutationRate 0.01,0.05,0.1 --evalsPerGen 1,3 --generations 100 --out sweep
+//   sweep --random 200 --mutationRate 0:0.3 --maxEvalTime 5:30 --threads 16
+#include "simulation.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct ParameterValues
+{
+    std::vector<float> values;// List of values
+    bool range = false;// If true, values = {min, max}
+};
+
+static bool parseValues(const std::string& str, ParameterValues& param)
+{
+    param.values.clear();
+    param.range = str.find(':') != std::string::npos;
+    std::stringstream ss(str);
+    std::string token;
+    while(std::getline(ss, token, param.range ? ':' : ','))
+    {
+        char* end;
+        param.values.push_back(std::strtof(token.c_str(), &end));
+        if(token.empty() || *end != '\0')
+            return false;
+    }
+    return !param.values.empty() && (!param.range || param.values.size() == 2);
+}
+
+static bool parseUnsigned(const std::string& str, unsigned& value)
+{
+    char* end;
+    unsigned long v = std::strtoul(str.c_str(), &end, 10);
+    if(str.empty() || str[0] == '-' || *end != '\0' || v > std::numeric_limits<unsigned>::max())
+        return false;
+    value = v;
+    return true;
+}
+
+static bool parsePositive(const std::string& str, float& value)
+{
+    char* end;
+    float v = std::strtof(str.c_str(), &end);
+    if(str.empty() || *end != '\0' || !(v > 0.0f) || !std::isfinite(v))
+        return false;
+    value = v;
+    return true;
+}
+
+static void printUsage()
+{
+    std::cout <<
+        "Usage: sweep [options]\n"
+        "GA parameters (list a,b,c or range min:max with --random):\n"
+        "  --mutationRate      default 0.05\n"
+        "  --crossingType      default 0 (0: best mean over the last fitnessSmooth generations,\n"
+        "                      1: best fitness of the last generation)\n"
+        "  --fitnessSmooth     default 1\n"
+        "  --evalsPerGen       default 1\n"
+        "  --maxEvalTime       default 10\n"
+        "  --fitnessType       default 0 (0: bounding box, 1: coverage grid)\n"
+        "Run options:\n"
+        "  --generations N     generations per run (default 50)\n"
+        "  --robots N          number of robots (default 20)\n"
+        "  --obstacles N       number of obstacles (default 10)\n"
+        "  --robotSize S       robot diameter (default 0.2)\n"
+        "  --dt S              simulation step in seconds (default 0.016)\n"
+        "  --random N          sample N combinations instead of the full grid\n"
+        "  --repeats N         runs per combination with different seeds (default 1)\n"
+        "  --threads N         worker threads (default: hardware concurrency)\n"
+        "  --seed S            base seed (default 0)\n"
+        "  --out PREFIX        output file prefix (default sweep)\n";
+}
+
+int main(int argc, char** argv)
+{
+    // Parameters to sweep, in the same order as the CSV columns
+    const std::vector<std::string> names = { "mutationRate", "crossingType", "fitnessSmooth", "evalsPerGen", "maxEvalTime", "fitnessType" };
+    std::map<std::string, ParameterValues> params;
+    parseValues("0.05", params["mutationRate"]);
+    parseValues("0", params["crossingType"]);
+    parseValues("1", params["fitnessSmooth"]);
+    parseValues("1", params["evalsPerGen"]);
+    parseValues("10", params["maxEvalTime"]);
+    parseValues("0", params["fitnessType"]);
+
+    simulation::Parameters base;
+    unsigned randomSamples = 0;
+    unsigned repeats = 1;
+    unsigned numThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::string out = "sweep";
+
+    //---------- Parse arguments ----------//
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if(arg == "-h" || arg == "--help")
+        {
+            printUsage();
+            return 0;
+        }
+        if(arg.rfind("--", 0) != 0 || i+1 >= argc)
+        {
+            std::cerr << "Invalid argument " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+        std::string name = arg.substr(2);
+        std::string value = argv[++i];
+        bool valid = true;
+
+        if(params.count(name))
+            valid = parseValues(value, params[name]);
+        else if(name == "generations") valid = parseUnsigned(value, base.numGenerations);
+        else if(name == "robots") valid = parseUnsigned(value, base.numRobots);
+        else if(name == "obstacles") valid = parseUnsigned(value, base.numObstacles);
+        else if(name == "robotSize") valid = parsePositive(value, base.robotSize);
+        else if(name == "dt") valid = parsePositive(value, base.dt);
+        else if(name == "random") valid = parseUnsigned(value, randomSamples);
+        else if(name == "repeats") valid = parseUnsigned(value, repeats) && repeats > 0;
+        else if(name == "threads") valid = parseUnsigned(value, numThreads) && numThreads > 0;
+        else if(name == "seed") valid = parseUnsigned(value, base.seed);
+        else if(name == "out") out = value;
+        else
+        {
+            std::cerr << "Unknown option " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+
+        if(!valid)
+        {
+            std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+
+    //---------- Create runs ----------//
+    std::vector<std::vector<float>> combinations;
+    if(randomSamples > 0)
+    {
+        std::mt19937 rng(base.seed);
+        for(unsigned s = 0; s < randomSamples; s++)
+        {
+            std::vector<float> combination;
+            for(const std::string& name : names)
+            {
+                const ParameterValues& p = params[name];
+                if(p.range)
+                    combination.push_back(std::uniform_real_distribution<float>(p.values[0], p.values[1])(rng));
+                else
+                    combination.push_back(p.values[std::uniform_int_distribution<size_t>(0, p.values.size()-1)(rng)]);
+            }
+            combinations.push_back(combination);
+        }
+    }
+    else
+    {
+        // Cartesian product of all lists
+        combinations.push_back({});
+        for(const std::string& name : names)
+        {
+            const ParameterValues& p = params[name];
+            if(p.range)
+            {
+                std::cerr << "Range for " << name << " is only valid with --random\n";
+                return 1;
+            }
+            std::vector<std::vector<float>> next;
+            for(const std::vector<float>& combination : combinations)
+                for(float value : p.values)
+                {
+                    next.push_back(combination);
+                    next.back().push_back(value);
+                }
+            combinations.swap(next);
+        }
+    }
+
+    std::vector<simulation::Parameters> runs;
+    for(const std::vector<float>& c : combinations)
+        for(unsigned r = 0; r < repeats; r++)
+        {
+            simulation::Parameters p = base;
+            p.mutationRate = c[0];
+            p.crossingType = std::lround(c[1]);
+            p.fitnessSmooth = std::max(1l, std::lround(c[2]));
+            p.evalsPerGen = std::max(1l, std::lround(c[3]));
+            p.maxEvalTime = c[4];
+            p.fitnessType = std::lround(c[5]);
+            p.seed = base.seed + runs.size();
+            runs.push_back(p);
+        }
+
+    //---------- Execute ----------//
+    std::ofstream runsFile(out+"_runs.csv");
+    std::ofstream convergenceFile(out+"_convergence.csv");
+    if(!runsFile || !convergenceFile)
+    {
+        std::cerr << "Could not create output files " << out << "_*.csv\n";
+        return 1;
+    }
+    runsFile << "run,mutationRate,crossingType,fitnessSmooth,evalsPerGen,maxEvalTime,fitnessType,seed,bestFitness,seconds,error\n";
+    convergenceFile << "run,generation,bestFitness,meanFitness\n";
+
+    std::cout << "Executing " << runs.size() << " runs with " << numThreads << " threads\n";
+    std::atomic<unsigned> nextRun(0);
+    std::mutex outputMutex;
+    unsigned finished = 0;
+    unsigned failed = 0;
+    auto worker = [&]()
+    {
+        for(unsigned i = nextRun++; i < runs.size(); i = nextRun++)
+        {
+            const simulation::Parameters& p = runs[i];
+            simulation::Result result = simulation::run(p);
+
+            // Results are written as soon as each run finishes
+            std::lock_guard<std::mutex> lock(outputMutex);
+            float best = result.bestFitness.empty() ? 0.0f : result.bestFitness.back();
+            runsFile << i << "," << p.mutationRate << "," << p.crossingType << "," << p.fitnessSmooth << ","
+                << p.evalsPerGen << "," << p.maxEvalTime << "," << p.fitnessType << "," << p.seed << ","
+                << best << "," << result.seconds << "," << result.error << "\n";
+            for(unsigned gen = 0; gen < result.bestFitness.size(); gen++)
+                convergenceFile << i << "," << gen+1 << "," << result.bestFitness[gen] << "," << result.meanFitness[gen] << "\n";
+            runsFile.flush();
+            convergenceFile.flush();
+            if(result.error.empty())
+                std::cout << "[" << ++finished << "/" << runs.size() << "] run " << i << " finished in " << result.seconds << "s\n";
+            else
+            {
+                failed++;
+                std::cerr << "[" << ++finished << "/" << runs.size() << "] run " << i << " failed: " << result.error << "\n";
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for(unsigned t = 0; t < std::min(numThreads, unsigned(runs.size())); t++)
+        threads.emplace_back(worker);
+    for(std::thread& thread : threads)
+        thread.join();
+
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,254 @@
+//--------------------------------------------------
+// Genetic Algorithm 2D
+// trajectoryRecorder.cpp
+// Date: 2026-10-19
+// By agent
+//--------------------------------------------------
+#include "trajectoryRecorder.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace trajectory
+{
+    static constexpr char magic[4] = {'G', 'A', 'T', 'R'};
+    static constexpr uint32_t version = 1;
+    static constexpr float positionScale = 1000.0f;// Millimeters
+    static constexpr float angleScale = 65536.0f/(2*M_PI);// 16 bits per turn
+
+    //---------- Encoding ----------//
+    static void writeVarint(std::vector<uint8_t>& bytes, int32_t value)
+    {
+        uint32_t v = (uint32_t(value) << 1) ^ uint32_t(value >> 31);// Zigzag
+        while(v >= 0x80)
+        {
+            bytes.push_back(uint8_t(v) | 0x80);
+            v >>= 7;
+        }
+        bytes.push_back(uint8_t(v));
+    }
+
+    static int32_t readVarint(const std::vector<uint8_t>& bytes, size_t& pos)
+    {
+        // A 32 bit value takes at most 5 bytes, stop there on malformed input
+        uint32_t v = 0;
+        unsigned shift = 0;
+        for(unsigned i = 0; i < 5 && pos < bytes.size(); i++)
+        {
+            uint8_t b = bytes[pos++];
+            v |= uint32_t(b & 0x7f) << shift;
+            if(!(b & 0x80))
+                break;
+            shift += 7;
+        }
+        return int32_t(v >> 1) ^ -int32_t(v & 1);
+    }
+
+    void Track::push(Pose pose)
+    {
+        int32_t q[3];
+        q[0] = int32_t(std::lround(pose.x*positionScale));
+        q[1] = int32_t(std::lround(pose.y*positionScale));
+        q[2] = int32_t(std::lround(pose.angle*angleScale)) & 0xffff;
+
+        writeVarint(bytes, q[0]-_last[0]);
+        writeVarint(bytes, q[1]-_last[1]);
+        writeVarint(bytes, int16_t(q[2]-_last[2]));// Shortest way around the circle
+        std::memcpy(_last, q, sizeof(q));
+        numSamples++;
+    }
+
+    std::vector<Pose> Track::decode() const
+    {
+        std::vector<Pose> poses(numSamples);
+        int32_t q[3] = {0, 0, 0};
+        size_t pos = 0;
+        for(Pose& pose : poses)
+        {
+            q[0] = int32_t(uint32_t(q[0]) + uint32_t(readVarint(bytes, pos)));// Wraps instead of overflowing on malformed input
+            q[1] = int32_t(uint32_t(q[1]) + uint32_t(readVarint(bytes, pos)));
+            q[2] = (q[2] + readVarint(bytes, pos)) & 0xffff;
+            pose.x = q[0]/positionScale;
+            pose.y = q[1]/positionScale;
+            pose.angle = q[2]/angleScale;
+        }
+        return poses;
+    }
+
+    //---------- File ----------//
+    template <typename T>
+    static void write(std::ostream& os, const T& value) { os.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+    template <typename T>
+    static bool read(std::istream& is, T& value) { return bool(is.read(reinterpret_cast<char*>(&value), sizeof(T))); }
+
+    bool Recorder::start(const std::string& filename, unsigned numRobots)
+    {
+        _filename = filename;
+        _numRobots = numRobots;
+        _evals.clear();
+        _evalOpen = false;
+        _bufferedBytes = 0;
+        _skippedEvals = 0;
+
+        std::ofstream os(_filename, std::ios::binary | std::ios::trunc);
+        os.write(magic, sizeof(magic));
+        write(os, version);
+        return bool(os);
+    }
+
+    void Recorder::stop()
+    {
+        _filename.clear();
+        _numRobots = 0;
+        _evals.clear();
+        _evalOpen = false;
+        _bufferedBytes = 0;
+        _skippedEvals = 0;
+    }
+
+    void Recorder::beginEvaluation(const std::vector<Obstacle>& obstacles)
+    {
+        // Skip whole evaluations once the buffered tracks are too large
+        if(_bufferedBytes >= maxBufferedBytes)
+        {
+            _skippedEvals++;
+            _evalOpen = false;
+            return;
+        }
+
+        _evals.push_back({0.0f, obstacles, std::vector<Track>(_numRobots)});
+        for(unsigned i = 0; i < _numRobots; i++)
+            _evals.back().tracks[i].robot = i;
+        _evalOpen = true;
+    }
+
+    void Recorder::record(unsigned robot, Pose pose)
+    {
+        if(_evalOpen && robot < _numRobots)
+            _evals.back().tracks[robot].push(pose);
+    }
+
+    void Recorder::endEvaluation(float duration)
+    {
+        if(_evalOpen)
+        {
+            _evals.back().duration = duration;
+            for(const Track& track : _evals.back().tracks)
+                _bufferedBytes += track.bytes.capacity();
+        }
+        _evalOpen = false;
+    }
+
+    std::vector<Evaluation> Recorder::takeFinished()
+    {
+        // Keep the evaluation being recorded for the next generation
+        std::vector<Evaluation> finished;
+        finished.swap(_evals);
+        if(_evalOpen)
+        {
+            _evals.push_back(std::move(finished.back()));
+            finished.pop_back();
+        }
+        _bufferedBytes = 0;
+        _skippedEvals = 0;
+        return finished;
+    }
+
+    void Recorder::discardGeneration()
+    {
+        takeFinished();
+    }
+
+    void Recorder::writeGeneration(uint32_t gen, const std::vector<unsigned>& robots)
+    {
+        std::vector<Evaluation> finished = takeFinished();
+        if(!isStarted())
+            return;
+
+        std::ofstream os(_filename, std::ios::binary | std::ios::app);
+        write(os, gen);
+        write(os, uint32_t(finished.size()));
+        for(const Evaluation& eval : finished)
+        {
+            write(os, eval.duration);
+            write(os, uint32_t(eval.obstacles.size()));
+            for(const Obstacle& obstacle : eval.obstacles)
+                write(os, obstacle);
+
+            unsigned numTracks = 0;
+            for(unsigned robot : robots)
+                numTracks += robot < eval.tracks.size();
+            write(os, uint32_t(numTracks));
+            for(unsigned robot : robots)
+            {
+                if(robot >= eval.tracks.size())
+                    continue;
+                const Track& track = eval.tracks[robot];
+                write(os, track.robot);
+                write(os, track.numSamples);
+                write(os, uint32_t(track.bytes.size()));
+                os.write(reinterpret_cast<const char*>(track.bytes.data()), track.bytes.size());
+            }
+        }
+    }
+
+    bool load(const std::string& filename, std::vector<Generation>& generations)
+    {
+        // Counts come from the file, they are checked against the remaining bytes before allocating anything
+        generations.clear();
+        std::ifstream is(filename, std::ios::binary | std::ios::ate);
+        if(!is)
+            return false;
+        const uint64_t size = uint64_t(is.tellg());
+        is.seekg(0);
+        auto remaining = [&]() { return size - uint64_t(is.tellg()); };
+
+        char m[4];
+        uint32_t v;
+        if(!is.read(m, sizeof(m)) || std::memcmp(m, magic, sizeof(m)) != 0 || !read(is, v) || v != version)
+            return false;
+
+        // Smallest evaluation: duration, numObstacles and numTracks. Smallest track: robot, numSamples and numBytes
+        const uint64_t minEvalSize = 3*sizeof(uint32_t);
+        const uint64_t minTrackSize = 3*sizeof(uint32_t);
+        const uint64_t minSampleSize = 3;// One byte per varint
+
+        uint32_t gen, numEvals;
+        while(remaining() > 0)
+        {
+            if(!read(is, gen) || !read(is, numEvals) || numEvals > remaining()/minEvalSize)
+                return false;
+
+            Generation generation;
+            generation.gen = gen;
+            generation.evals.resize(numEvals);
+            for(Evaluation& eval : generation.evals)
+            {
+                uint32_t numObstacles, numTracks;
+                if(!read(is, eval.duration) || !read(is, numObstacles) || numObstacles > remaining()/sizeof(Obstacle))
+                    return false;
+                eval.obstacles.resize(numObstacles);
+                for(Obstacle& obstacle : eval.obstacles)
+                    if(!read(is, obstacle))
+                        return false;
+
+                if(!read(is, numTracks) || numTracks > remaining()/minTrackSize)
+                    return false;
+                eval.tracks.resize(numTracks);
+                for(Track& track : eval.tracks)
+                {
+                    uint32_t numBytes;
+                    if(!read(is, track.robot) || !read(is, track.numSamples) || !read(is, numBytes) ||
+                        numBytes > remaining() || track.numSamples > numBytes/minSampleSize)
+                        return false;
+                    track.bytes.resize(numBytes);
+                    if(!is.read(reinterpret_cast<char*>(track.bytes.data()), numBytes))
+                        return false;
+                }
+            }
+            generations.push_back(std::move(generation));
+        }
+        return true;
+    }
+}
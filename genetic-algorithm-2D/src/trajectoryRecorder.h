@@ -0,0 +1,100 @@
+//--------------------------------------------------
+// Genetic Algorithm 2D
+// trajectoryRecorder.h
+// Date: 2026-10-19
+// By agent
+//--------------------------------------------------
+#ifndef TRAJECTORY_RECORDER_H
+#define TRAJECTORY_RECORDER_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// File layout (little endian, appended one generation at a time):
+//   header:     "GATR" u32 version
+//   generation: u32 gen, u32 numEvals, numEvals * evaluation
+//   evaluation: f32 duration, u32 numObstacles, numObstacles * (f32 x, f32 y, f32 scale), u32 numTracks, numTracks * track
+//   track:      u32 robot, u32 numSamples, u32 numBytes, numBytes * u8
+// Each track sample is (x, y, angle) quantized to millimeters/(2π/65536) and stored as zigzag varint deltas
+namespace trajectory
+{
+    struct Pose
+    {
+        float x, y;
+        float angle;// Rotation around z in radians
+    };
+
+    struct Obstacle
+    {
+        float x, y;
+        float scale;
+    };
+
+    struct Track
+    {
+        uint32_t robot = 0;// Robot index inside the robot factory
+        uint32_t numSamples = 0;
+        std::vector<uint8_t> bytes;// Delta encoded samples
+
+        void push(Pose pose);
+        std::vector<Pose> decode() const;
+
+    private:
+        int32_t _last[3] = {0, 0, 0};
+    };
+
+    struct Evaluation
+    {
+        float duration;// Evaluation time in seconds
+        std::vector<Obstacle> obstacles;
+        std::vector<Track> tracks;
+    };
+
+    struct Generation
+    {
+        uint32_t gen;
+        std::vector<Evaluation> evals;
+    };
+
+    class Recorder
+    {
+    public:
+        // Create (truncate) the file and start recording numRobots robots
+        bool start(const std::string& filename, unsigned numRobots);
+        void stop();
+        bool isStarted() const { return !_filename.empty(); }
+
+        void beginEvaluation(const std::vector<Obstacle>& obstacles);
+        void record(unsigned robot, Pose pose);
+        void endEvaluation(float duration);
+
+        // Append the finished evaluations of this generation to the file (only the selected robots) and clear them
+        void writeGeneration(uint32_t gen, const std::vector<unsigned>& robots);
+        // Drop the finished evaluations of this generation without writing them
+        void discardGeneration();
+        // Evaluations of this generation that were not recorded because of maxBufferedBytes
+        unsigned skippedEvaluations() const { return _skippedEvals; }
+
+        // All robots are recorded because the best one is only known when the generation ends, so the
+        // buffered tracks grow with robots*evalsPerGen*ticks (~4 bytes per sample). Once they reach this
+        // size, the remaining evaluations of the generation are not recorded
+        static constexpr size_t maxBufferedBytes = 256*1024*1024;
+
+    private:
+        std::vector<Evaluation> takeFinished();
+
+        std::string _filename;
+        unsigned _numRobots = 0;
+        std::vector<Evaluation> _evals;
+        bool _evalOpen = false;
+        size_t _bufferedBytes = 0;
+        unsigned _skippedEvals = 0;
+    };
+
+    // Read all generations from a recorded file, returns false if the file is invalid or truncated
+    // (the generations read before the error are kept)
+    bool load(const std::string& filename, std::vector<Generation>& generations);
+}
+
+#endif// TRAJECTORY_RECORDER_H